@@ -6,6 +6,11 @@
       'include_dirs': [
         '<!(node -e "require(\'nan\')")'
       ],
+      'conditions': [
+        ['OS=="linux"', {
+          'libraries': [ '-lrt' ]
+        }]
+      ],
     }
   ]
 }
@@ -826,6 +826,132 @@ exports.reinterpretUntilZeros = function reinterpretUntilZeros (buffer, size, of
   return rtn
 }
 
+/**
+ * Functions for sharing memory between processes and `worker_threads` without
+ * copying. The returned Buffers are plain `MAP_SHARED` mappings, so they work
+ * with `get()`, `set()`, `readCString()` and every other function in `ref`.
+ *
+ * Mappings are released when their Buffer gets garbage collected. Keep the
+ * Buffer, or a Buffer derived from it through `slice()` or `reinterpret()`,
+ * referenced for as long as the memory is in use. Buffers returned by
+ * `readPointer()`, `_reinterpret()` or `_reinterpretUntilZeros()` hold no
+ * reference to the original and do not keep the mapping alive.
+ *
+ * The same segment is usually mapped at a different address in every process
+ * and thread, so a pointer written into a segment with `writePointer()` or
+ * `ref.set()` is only meaningful to the thread that wrote it. Store offsets
+ * into the segment instead.
+ *
+ * A single mapping is limited to the maximum `Buffer` length of the running
+ * Node.js version (`require('buffer').kMaxLength`). Creating or opening a
+ * larger segment throws a `RangeError`.
+ *
+ * Not available on Windows.
+ */
+
+var shm = exports.shm = {}
+
+/**
+ * Whether the process "exit" hook that unlinks owned segment names has been
+ * installed yet.
+ * @api private
+ */
+
+var shmExitHook = false
+
+/**
+ * Creates a new shared memory segment of _size_ bytes and returns a Buffer
+ * mapped onto it. The segment's memory is zero-filled.
+ *
+ * By default the segment is created with `shm_open()`, and can be opened by
+ * other processes or threads through `ref.shm.open(name)`. _name_ must start
+ * with a `/` and must not already exist.
+ *
+ * The returned Buffer owns the name. Call `ref.shm.unlink(name)` once every
+ * peer has opened the segment; that is the normal way to clean up. As a
+ * fallback the name is unlinked when the Buffer gets garbage collected, or
+ * when the process (or worker) exits normally. A process that is killed by
+ * a signal or crashes leaves the segment behind in `/dev/shm`. A name that
+ * has been unlinked and re-created within this process is never unlinked
+ * again; when another process re-creates it, the segment's identity is
+ * checked first, though a small race remains between that check and the
+ * unlink.
+ *
+ * When `memfd` is `true` the segment is backed by `memfd_create()` instead
+ * (Linux only), and _name_ is only used as a label. It has no name in the
+ * filesystem; the returned Buffer has an `fd` property holding the memfd
+ * descriptor instead, which is closed when the Buffer gets garbage collected.
+ * Do not use `fd` after that, since the number may be reused by an unrelated
+ * file. Other `worker_threads` in the same process can map the segment with
+ * `ref.shm.open(fd)`. The descriptor number means nothing to another process,
+ * and is not inherited across `exec()`: pass it explicitly, e.g. through the
+ * `stdio` option of `child_process.spawn()` or with `SCM_RIGHTS` over a Unix
+ * domain socket, and open the descriptor number the peer received.
+ *
+ * ```
+ * var buf = ref.shm.create('/my-segment', 4096)
+ * ref.set(buf, 0, 1234, 'int32')
+ *
+ * // in another process or worker
+ * var other = ref.shm.open('/my-segment')
+ * ref.get(other, 0, 'int32')
+ * 1234
+ *
+ * // once everyone has attached
+ * ref.shm.unlink('/my-segment')
+ * ```
+ *
+ * @param {String} name The name of the segment, e.g. `"/my-segment"`.
+ * @param {Number} size The size of the segment in bytes.
+ * @param {Object} options Optional. Pass `{ memfd: true }` to back the segment with `memfd_create()`.
+ * @return {Buffer} A new Buffer instance mapped onto the shared memory segment.
+ */
+
+shm.create = function create (name, size, options) {
+  var memfd = !!(options && options.memfd)
+  debug('creating %d byte shared memory segment %j (memfd: %s)', size, name, memfd)
+  var buf = exports.shmCreate(name, size, memfd)
+  if (!memfd && !shmExitHook) {
+    shmExitHook = true
+    process.on('exit', function () {
+      exports.shmUnlinkOwned()
+    })
+  }
+  return buf
+}
+
+/**
+ * Maps an existing shared memory segment and returns a Buffer spanning the
+ * whole segment. _segment_ is either the name a segment was created with, or
+ * a file descriptor, such as the `fd` property of a memfd segment (see
+ * `ref.shm.create()`). A descriptor has to be open in the calling process.
+ *
+ * Opening a segment does not take ownership of it: the mapping is released
+ * when the returned Buffer gets garbage collected, but the segment itself is
+ * left for its creator to unlink.
+ *
+ * @param {String|Number} segment The name or file descriptor of the segment.
+ * @return {Buffer} A new Buffer instance mapped onto the shared memory segment.
+ */
+
+shm.open = function open (segment) {
+  debug('opening shared memory segment %j', segment)
+  return exports.shmOpen(segment)
+}
+
+/**
+ * Removes the name of a segment created by `ref.shm.create()`, so that it can
+ * no longer be opened. Existing mappings remain valid, and the Buffer that
+ * created the segment will no longer try to unlink the name.
+ *
+ * @param {String} name The name of the segment.
+ */
+
+shm.unlink = function unlink (name) {
+  debug('unlinking shared memory segment %j', name)
+  exports.shmUnlink(name)
+}
+
 
 // the built-in "types"
 var types = exports.types = {}
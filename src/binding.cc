@@ -16,6 +16,18 @@
 #else
   #define __STDC_FORMAT_MACROS
   #include <inttypes.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <vector>
+#endif
+
+#if defined(__linux__)
+  #include <sys/syscall.h>
+  #ifndef MFD_CLOEXEC
+    #define MFD_CLOEXEC 0x0001U
+  #endif
 #endif
 
 
@@ -569,6 +581,365 @@ NAN_METHOD(ReinterpretBufferUntilZeros) {
 }
 
 
+#ifndef _WIN32
+
+// the largest mapping that can be handed out as a Buffer
+#if NODE_MODULE_VERSION >= IOJS_3_0_MODULE_VERSION
+static const size_t kMaxShmLength = node::Buffer::kMaxLength;
+#else
+static const size_t kMaxShmLength = kMaxLength;
+#endif
+
+/*
+ * Bookkeeping for a shared memory mapping handed out as a Buffer. Freed,
+ * along with the mapping itself, once the Buffer gets garbage collected.
+ */
+
+struct shm_mapping {
+  size_t length;
+  int fd;       // memfd kept open for the life of the mapping, or -1
+  char *name;   // shm_open() name still owned by this mapping, or NULL
+  dev_t dev;    // identity of the segment, so that a name which has since
+  ino_t ino;    // been reused by another segment never gets unlinked
+  void *owner;  // the Isolate that created the segment
+};
+
+/*
+ * Every mapping that still owns its shm_open() name. Buffers may be created
+ * and collected on different worker threads, so access goes through a lock.
+ */
+
+static std::vector<shm_mapping *> shm_owned;
+static uv_mutex_t shm_owned_lock;
+static uv_once_t shm_owned_once = UV_ONCE_INIT;
+
+void shm_owned_init() {
+  uv_mutex_init(&shm_owned_lock);
+}
+
+/*
+ * Takes the name away from `m`, returning it (to be freed by the caller).
+ * Must be called with `shm_owned_lock` held.
+ */
+
+char *shm_disown(shm_mapping *m) {
+  char *name = m->name;
+  m->name = NULL;
+  for (size_t i = 0; i < shm_owned.size(); i++) {
+    if (shm_owned[i] == m) {
+      shm_owned.erase(shm_owned.begin() + i);
+      break;
+    }
+  }
+  return name;
+}
+
+/*
+ * Unlinks `name`, but only if it still refers to the segment identified by
+ * `dev` and `ino`. There is no atomic "unlink if same" call, so another
+ * process that unlinks and re-creates the name between the check and the
+ * shm_unlink() still loses its segment; this only narrows that window.
+ * Re-creation within this process is handled by `shm_owned` instead.
+ */
+
+void shm_unlink_if_same(const char *name, dev_t dev, ino_t ino) {
+  int fd = shm_open(name, O_RDONLY, 0);
+  if (fd < 0) {
+    return;
+  }
+  struct stat st;
+  bool same = fstat(fd, &st) == 0 && st.st_dev == dev && st.st_ino == ino;
+  close(fd);
+  if (same) {
+    shm_unlink(name);
+  }
+}
+
+void shm_free_cb(char *data, void *hint) {
+  shm_mapping *m = reinterpret_cast<shm_mapping *>(hint);
+  munmap(data, m->length);
+  if (m->fd >= 0) {
+    close(m->fd);
+  }
+
+  uv_mutex_lock(&shm_owned_lock);
+  char *name = shm_disown(m);
+  uv_mutex_unlock(&shm_owned_lock);
+
+  if (name != NULL) {
+    shm_unlink_if_same(name, m->dev, m->ino);
+    free(name);
+  }
+  delete m;
+}
+
+/*
+ * mmap()s the first `length` bytes of `fd` as MAP_SHARED and wraps the mapping
+ * in a Buffer that unmaps itself when garbage collected. When `name` is given
+ * the Buffer owns that shm_open() name, and unlinks it once collected. Throws
+ * and returns an empty handle on failure, in which case ownership of `fd` and
+ * `name` stays with the caller.
+ */
+
+Local<Value> WrapShm(const char *fn, int fd, size_t length, int owned_fd, const char *name) {
+  char errmsg[200];
+
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    snprintf(errmsg, sizeof(errmsg), "%s: fstat: %s", fn, strerror(errno));
+    Nan::ThrowError(errmsg);
+    return Local<Value>();
+  }
+
+  void *ptr = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (ptr == MAP_FAILED) {
+    snprintf(errmsg, sizeof(errmsg), "%s: mmap: %s", fn, strerror(errno));
+    Nan::ThrowError(errmsg);
+    return Local<Value>();
+  }
+
+  shm_mapping *m = new shm_mapping;
+  m->length = length;
+  m->fd = owned_fd;
+  m->name = NULL;
+  m->dev = st.st_dev;
+  m->ino = st.st_ino;
+  m->owner = v8::Isolate::GetCurrent();
+
+  if (name != NULL) {
+    m->name = strdup(name);
+    uv_mutex_lock(&shm_owned_lock);
+    // O_EXCL succeeded, so any earlier owner of this name has lost it
+    for (size_t i = shm_owned.size(); i-- > 0; ) {
+      if (strcmp(shm_owned[i]->name, name) == 0) {
+        free(shm_disown(shm_owned[i]));
+      }
+    }
+    shm_owned.push_back(m);
+    uv_mutex_unlock(&shm_owned_lock);
+  }
+
+  Local<Object> buf = Nan::NewBuffer(reinterpret_cast<char *>(ptr), length, shm_free_cb, m).ToLocalChecked();
+  if (owned_fd >= 0) {
+    Nan::Set(buf, Nan::New<v8::String>("fd").ToLocalChecked(), Nan::New<v8::Int32>(owned_fd));
+  }
+  return buf;
+}
+
+#endif
+
+/*
+ * Creates a new shared memory segment and returns a Buffer mapped onto it.
+ * Segments created with shm_open() are unlinked once the returned Buffer gets
+ * garbage collected, unless the name has been unlinked (and possibly reused)
+ * in the meantime; mappings already held by other processes remain valid.
+ * memfd segments have no name in the filesystem and are shared by passing
+ * around the Buffer's `fd` property instead.
+ *
+ * info[0] - String - the name of the segment, e.g. "/my-segment"
+ * info[1] - Number - the size of the segment in bytes
+ * info[2] - Boolean - `false` by default. if `true` is passed in then the
+ *                    segment is backed by memfd_create() (Linux only)
+ */
+
+NAN_METHOD(ShmCreate) {
+
+#ifdef _WIN32
+  return Nan::ThrowError("shmCreate: shared memory is not supported on Windows");
+#else
+  if (!info[0]->IsString()) {
+    return Nan::ThrowTypeError("shmCreate: String name expected");
+  }
+  if (!info[1]->IsNumber()) {
+    return Nan::ThrowTypeError("shmCreate: Number size expected");
+  }
+
+  String::Utf8Value name(info[0]);
+  int64_t size = GetInt64(info[1]);
+  bool memfd = info[2]->BooleanValue();
+  char errmsg[200];
+
+  if (size <= 0) {
+    return Nan::ThrowRangeError("shmCreate: invalid shared memory size");
+  }
+  if (static_cast<uint64_t>(size) > kMaxShmLength) {
+    snprintf(errmsg, sizeof(errmsg),
+        "shmCreate: %" PRId64 " bytes exceeds the maximum Buffer length of %" PRIu64 " bytes",
+        size, static_cast<uint64_t>(kMaxShmLength));
+    return Nan::ThrowRangeError(errmsg);
+  }
+
+  uv_once(&shm_owned_once, shm_owned_init);
+
+  int fd;
+  if (memfd) {
+#if defined(__linux__) && defined(SYS_memfd_create)
+    fd = syscall(SYS_memfd_create, *name, MFD_CLOEXEC);
+#else
+    return Nan::ThrowError("shmCreate: memfd is not supported on this platform");
+#endif
+  } else {
+    fd = shm_open(*name, O_RDWR | O_CREAT | O_EXCL, 0600);
+  }
+  if (fd < 0) {
+    snprintf(errmsg, sizeof(errmsg), "shmCreate: %s: %s", memfd ? "memfd_create" : "shm_open", strerror(errno));
+    return Nan::ThrowError(errmsg);
+  }
+
+  if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    snprintf(errmsg, sizeof(errmsg), "shmCreate: ftruncate: %s", strerror(errno));
+    close(fd);
+    if (!memfd) shm_unlink(*name);
+    return Nan::ThrowError(errmsg);
+  }
+
+  Local<Value> rtn = WrapShm("shmCreate", fd, static_cast<size_t>(size), memfd ? fd : -1, memfd ? NULL : *name);
+  if (rtn.IsEmpty()) {
+    close(fd);
+    if (!memfd) shm_unlink(*name);
+    return;
+  }
+  if (!memfd) {
+    // the mapping keeps the segment alive, the descriptor is no longer needed
+    close(fd);
+  }
+
+  info.GetReturnValue().Set(rtn);
+#endif
+}
+
+/*
+ * Maps an existing shared memory segment and returns a Buffer spanning the
+ * whole segment. The mapping is released when the Buffer gets garbage
+ * collected, but the segment itself is left for its creator to unlink.
+ *
+ * info[0] - String/Number - the shm_open() name of the segment, or a file
+ *                           descriptor (e.g. the `fd` of a memfd segment)
+ */
+
+NAN_METHOD(ShmOpen) {
+
+#ifdef _WIN32
+  return Nan::ThrowError("shmOpen: shared memory is not supported on Windows");
+#else
+  char errmsg[200];
+  int fd;
+  bool by_name = info[0]->IsString();
+
+  uv_once(&shm_owned_once, shm_owned_init);
+
+  if (by_name) {
+    String::Utf8Value name(info[0]);
+    fd = shm_open(*name, O_RDWR, 0);
+    if (fd < 0) {
+      snprintf(errmsg, sizeof(errmsg), "shmOpen: shm_open: %s", strerror(errno));
+      return Nan::ThrowError(errmsg);
+    }
+  } else if (info[0]->IsNumber()) {
+    fd = static_cast<int>(GetInt64(info[0]));
+  } else {
+    return Nan::ThrowTypeError("shmOpen: String name or Number fd expected");
+  }
+
+  // shm objects may report a page-rounded size (e.g. on macOS), which is
+  // still fully mappable
+  struct stat st;
+  Local<Value> rtn;
+  if (fstat(fd, &st) != 0) {
+    snprintf(errmsg, sizeof(errmsg), "shmOpen: fstat: %s", strerror(errno));
+    Nan::ThrowError(errmsg);
+  } else if (st.st_size <= 0) {
+    Nan::ThrowRangeError("shmOpen: shared memory segment is empty");
+  } else if (static_cast<uint64_t>(st.st_size) > kMaxShmLength) {
+    snprintf(errmsg, sizeof(errmsg),
+        "shmOpen: shared memory segment of %" PRIu64 " bytes exceeds the maximum Buffer length of %" PRIu64 " bytes",
+        static_cast<uint64_t>(st.st_size), static_cast<uint64_t>(kMaxShmLength));
+    Nan::ThrowRangeError(errmsg);
+  } else {
+    rtn = WrapShm("shmOpen", fd, static_cast<size_t>(st.st_size), -1, NULL);
+  }
+  if (by_name) {
+    close(fd);
+  }
+  if (rtn.IsEmpty()) {
+    return;
+  }
+
+  info.GetReturnValue().Set(rtn);
+#endif
+}
+
+/*
+ * Removes the name of a shm_open() segment so that it can no longer be opened.
+ * Existing mappings stay valid until they are garbage collected, and no longer
+ * unlink the name when they are.
+ *
+ * info[0] - String - the name of the segment
+ */
+
+NAN_METHOD(ShmUnlink) {
+
+#ifdef _WIN32
+  return Nan::ThrowError("shmUnlink: shared memory is not supported on Windows");
+#else
+  if (!info[0]->IsString()) {
+    return Nan::ThrowTypeError("shmUnlink: String name expected");
+  }
+
+  String::Utf8Value name(info[0]);
+
+  uv_once(&shm_owned_once, shm_owned_init);
+  uv_mutex_lock(&shm_owned_lock);
+  for (size_t i = shm_owned.size(); i-- > 0; ) {
+    if (strcmp(shm_owned[i]->name, *name) == 0) {
+      free(shm_disown(shm_owned[i]));
+    }
+  }
+  uv_mutex_unlock(&shm_owned_lock);
+
+  if (shm_unlink(*name) != 0) {
+    char errmsg[200];
+    snprintf(errmsg, sizeof(errmsg), "shmUnlink: %s", strerror(errno));
+    return Nan::ThrowError(errmsg);
+  }
+
+  info.GetReturnValue().SetUndefined();
+#endif
+}
+
+/*
+ * Unlinks every shm_open() name still owned by a Buffer created on the current
+ * thread. Used as a process "exit" hook, since Buffers are not garbage
+ * collected (and their names not unlinked) when the process exits.
+ */
+
+NAN_METHOD(ShmUnlinkOwned) {
+
+#ifndef _WIN32
+  std::vector<shm_mapping> names;
+  void *owner = v8::Isolate::GetCurrent();
+
+  uv_once(&shm_owned_once, shm_owned_init);
+  uv_mutex_lock(&shm_owned_lock);
+  for (size_t i = shm_owned.size(); i-- > 0; ) {
+    shm_mapping *m = shm_owned[i];
+    if (m->owner == owner) {
+      shm_mapping copy = *m;
+      copy.name = shm_disown(m);
+      names.push_back(copy);
+    }
+  }
+  uv_mutex_unlock(&shm_owned_lock);
+
+  for (size_t i = 0; i < names.size(); i++) {
+    shm_unlink_if_same(names[i].name, names[i].dev, names[i].ino);
+    free(names[i].name);
+  }
+#endif
+
+  info.GetReturnValue().SetUndefined();
+}
+
 } // anonymous namespace
 
 NAN_MODULE_INIT(init) {
@@ -658,5 +1029,9 @@ NAN_MODULE_INIT(init) {
   Nan::SetMethod(target, "readCString", ReadCString);
   Nan::SetMethod(target, "reinterpret", ReinterpretBuffer);
   Nan::SetMethod(target, "reinterpretUntilZeros", ReinterpretBufferUntilZeros);
+  Nan::SetMethod(target, "shmCreate", ShmCreate);
+  Nan::SetMethod(target, "shmOpen", ShmOpen);
+  Nan::SetMethod(target, "shmUnlink", ShmUnlink);
+  Nan::SetMethod(target, "shmUnlinkOwned", ShmUnlinkOwned);
 }
-NODE_MODULE(binding, init);
+NAN_MODULE_WORKER_ENABLED(binding, init)
@@ -0,0 +1,207 @@
+
+var assert = require('assert')
+var weak = require('weak')
+var ref = require('../')
+
+describe('shm', function () {
+
+  if (process.platform == 'win32') return
+
+  var counter = 0
+  var name
+
+  beforeEach(function () {
+    gc()
+    name = '/ref-test-' + process.pid + '-' + (counter++)
+  })
+
+  afterEach(function () {
+    try { ref.shm.unlink(name) } catch (e) {}
+  })
+
+  it('should create a zero-filled Buffer of the requested size', function () {
+    var buf = ref.shm.create(name, 64)
+    assert(Buffer.isBuffer(buf))
+    assert.strictEqual(64, buf.length)
+    assert(!buf.isNull())
+    for (var i = 0; i < buf.length; i++) {
+      assert.strictEqual(0, buf[i])
+    }
+  })
+
+  it('should share memory with a Buffer from `open()`', function () {
+    var a = ref.shm.create(name, 64)
+    var b = ref.shm.open(name)
+    assert.strictEqual(a.length, b.length)
+    assert.notStrictEqual(a.address(), b.address())
+
+    ref.set(a, 8, 1234, 'int32')
+    assert.strictEqual(1234, ref.get(b, 8, 'int32'))
+    b.writeCString('hello', 16)
+    assert.strictEqual('hello', a.readCString(16))
+  })
+
+  it('should throw when creating a segment that already exists', function () {
+    var buf = ref.shm.create(name, 8)
+    assert.throws(function () {
+      ref.shm.create(name, 8)
+    }, /shm_open/)
+    assert.strictEqual(8, buf.length)
+  })
+
+  it('should throw when opening a segment that has been unlinked', function () {
+    var buf = ref.shm.create(name, 8)
+    ref.shm.unlink(name)
+    assert.throws(function () {
+      ref.shm.open(name)
+    }, /shm_open/)
+    // the existing mapping stays valid
+    buf[0] = 42
+    assert.strictEqual(42, buf[0])
+  })
+
+  it('should throw a RangeError for an invalid size', function () {
+    assert.throws(function () {
+      ref.shm.create(name, 0)
+    }, RangeError)
+    assert.throws(function () {
+      ref.shm.create(name, require('buffer').kMaxLength + 1)
+    }, RangeError)
+  })
+
+  it('should unlink the name when the creating Buffer is garbage collected', function (done) {
+    var gced = false
+    var buf = ref.shm.create(name, 8)
+    weak(buf, function () { gced = true })
+    buf = null
+    gc()
+    assert(gced, '"buf" has not been garbage collected')
+    // newer node versions run Buffer free callbacks on a later tick
+    setImmediate(function () {
+      assert.throws(function () {
+        ref.shm.open(name)
+      }, /shm_open/)
+      done()
+    })
+  })
+
+  it('should not unlink the name when an opened Buffer is garbage collected', function (done) {
+    var gced = false
+    var buf = ref.shm.create(name, 8)
+    buf[0] = 7
+    var other = ref.shm.open(name)
+    weak(other, function () { gced = true })
+    other = null
+    gc()
+    assert(gced, '"other" has not been garbage collected')
+    setImmediate(function () {
+      assert.strictEqual(7, ref.shm.open(name)[0])
+      done()
+    })
+  })
+
+  it('should not unlink a reused name when the old Buffer is garbage collected', function (done) {
+    var gced = false
+    var old = ref.shm.create(name, 8)
+    weak(old, function () { gced = true })
+    ref.shm.unlink(name)
+    var buf = ref.shm.create(name, 16)
+    old = null
+    gc()
+    assert(gced, '"old" has not been garbage collected')
+    setImmediate(function () {
+      assert.strictEqual(16, ref.shm.open(name).length)
+      assert.strictEqual(16, buf.length)
+      done()
+    })
+  })
+
+  it('should keep the mapping alive through a `reinterpret()`ed view', function (done) {
+    var gced = false
+    var buf = ref.shm.create(name, 8)
+    weak(buf, function () { gced = true })
+    var view = buf.reinterpret(4, 4)
+    buf = null
+    gc()
+    assert(!gced, '"buf" has been garbage collected too soon')
+    setImmediate(function () {
+      view[0] = 9
+      assert.strictEqual(9, ref.shm.open(name)[4])
+      done()
+    })
+  })
+
+  describe('worker_threads', function () {
+
+    var Worker
+    try {
+      Worker = require('worker_threads').Worker
+    } catch (e) {
+      return
+    }
+
+    var refPath = require('path').resolve(__dirname, '..')
+
+    function run (code, data, fn) {
+      var worker = new Worker(
+        'var ref = require(' + JSON.stringify(refPath) + ')\n' +
+        'var data = require("worker_threads").workerData\n' +
+        'var post = require("worker_threads").parentPort.postMessage.bind(require("worker_threads").parentPort)\n' +
+        code, { eval: true, workerData: data })
+      var result
+      var error = null
+      worker.on('message', function (m) { result = m })
+      worker.on('error', function (e) { error = e })
+      worker.on('exit', function () { fn(error, result) })
+    }
+
+    it('should share a named segment with a Worker', function (done) {
+      var buf = ref.shm.create(name, 16)
+      buf[0] = 3
+      run('var b = ref.shm.open(data); b[1] = b[0] + 1; post(b.length)', name, function (err, length) {
+        if (err) return done(err)
+        assert.strictEqual(16, length)
+        assert.strictEqual(4, buf[1])
+        done()
+      })
+    })
+
+    it('should unlink only the Worker\'s own segments when it exits', function (done) {
+      var buf = ref.shm.create(name, 8)
+      var workerName = name + '-worker'
+      run('global.keep = ref.shm.create(data, 8); ref.shm.open(data)[0] = 5', workerName, function (err) {
+        if (err) return done(err)
+        assert.throws(function () {
+          ref.shm.open(workerName)
+        }, /shm_open/)
+        assert.strictEqual(8, ref.shm.open(name).length)
+        assert.strictEqual(8, buf.length)
+        done()
+      })
+    })
+
+    if (process.platform == 'linux') {
+      it('should share a memfd segment with a Worker through its `fd`', function (done) {
+        var buf = ref.shm.create('ref-test', 8, { memfd: true })
+        run('ref.shm.open(data)[2] = 6', buf.fd, function (err) {
+          if (err) return done(err)
+          assert.strictEqual(6, buf[2])
+          done()
+        })
+      })
+    }
+
+  })
+
+  if (process.platform == 'linux') {
+    it('should share memory through the `fd` of a memfd segment', function () {
+      var a = ref.shm.create('ref-test', 32, { memfd: true })
+      assert.strictEqual('number', typeof a.fd)
+      var b = ref.shm.open(a.fd)
+      assert.strictEqual(a.length, b.length)
+      ref.set(a, 0, 0xdead, 'uint32')
+      assert.strictEqual(0xdead, ref.get(b, 0, 'uint32'))
+    })
+  }
+
+})